@@ -0,0 +1,55 @@
+#ifndef BATCHPROCESSOR_H
+#define BATCHPROCESSOR_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+// Single map travelling through the batch pipeline
+struct BatchJob
+{
+    int index; // Index of the map in the batch
+    std::string mapData; // Bytes of the source .map file
+    std::string luaScript; // Generated Lua script
+    std::string tilelessMap; // Bytes of the tileless .map file
+};
+
+// Bounded queue which is used to pass jobs between the pipeline stages
+class BatchQueue
+{
+    public:
+        BatchQueue(size_t capacity); // Constructor
+
+        void push(BatchJob* job); // Adds job to the queue, waits if queue is full
+        BatchJob* pop(); // Takes job from the queue, waits if queue is empty. Returns nullptr once queue is closed and empty
+        void close(); // Marks that no more jobs will be added
+    private:
+        std::deque<BatchJob*> jobs; // Jobs in the queue
+        size_t capacity; // Maximum number of jobs in the queue
+        bool closed = false; // Is queue closed?
+
+        std::mutex mutex; // Guards the variables above
+        std::condition_variable notFull; // Notified when job is taken from the queue
+        std::condition_variable notEmpty; // Notified when job is added to the queue or queue is closed
+};
+
+class BatchProcessor
+{
+    public:
+        int run(std::vector<std::string> mapPaths, int workerCount); // Protects all specified maps, returns number of failed maps
+        int getResult(int index); // Returns result of the map with specified index
+    private:
+        void readMaps(); // Reading stage, runs on the I/O thread
+        void processMaps(); // Processing stage, runs on worker threads
+        void writeMaps(); // Writing stage, runs on the I/O thread
+
+        std::vector<std::string> mapPaths; // Paths to the maps in the batch
+        std::vector<int> mapResults; // Results of the maps in the batch
+
+        BatchQueue* inputQueue = nullptr; // Maps which were read and are waiting to be processed
+        BatchQueue* outputQueue = nullptr; // Maps which were processed and are waiting to be written
+};
+
+#endif // BATCHPROCESSOR_H
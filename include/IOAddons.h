@@ -1,21 +1,40 @@
 #ifndef IOADDONS_H
 #define IOADDONS_H
 
-#include <fstream>
+#include <iostream>
+#include <streambuf>
+#include <string>
 #include <cstdint>
 
 class IOAddons
 {
     public:
-        static void writeByte(std::ofstream& file, int8_t value); // Writes unsigned 8-bit byte to the file stream
-        static void writeShort(std::ofstream& file, int16_t value); // Write unsigned 16-bit short to the file stream
-        static void writeInt(std::ofstream& file, int32_t value); // Writes signed 32-bit integer to the file stream
-        static void writeString(std::ofstream& file, std::string value); // Writes a string with a linebreak in the end
+        static void writeByte(std::ostream& file, int8_t value); // Writes unsigned 8-bit byte to the file stream
+        static void writeShort(std::ostream& file, int16_t value); // Write unsigned 16-bit short to the file stream
+        static void writeInt(std::ostream& file, int32_t value); // Writes signed 32-bit integer to the file stream
+        static void writeString(std::ostream& file, std::string value); // Writes a string with a linebreak in the end
 
-        static int readByte(std::ifstream& file); // Reads an unsigned 8-bit short from a file stream
-        static int readShort(std::ifstream& file); // Reads an unsigned 16-bit short from a file stream
-        static int readInt(std::ifstream& file); // Reads an unsigned 32-bit integer from a file stream
-        static std::string readString(std::ifstream& file); // Reads a string up to line break from the file stream
+        static int readByte(std::istream& file); // Reads an unsigned 8-bit short from a file stream
+        static int readShort(std::istream& file); // Reads an unsigned 16-bit short from a file stream
+        static int readInt(std::istream& file); // Reads an unsigned 32-bit integer from a file stream
+        static std::string readString(std::istream& file); // Reads a string up to line break from the file stream
+        static uint64_t getRemainingLength(std::istream& file); // Returns number of bytes left in the file stream
+
+        static int readFile(std::string filePath, std::string& buffer); // Reads the whole file into the buffer
+        static int writeFile(std::string filePath, const std::string& buffer, bool binary); // Writes the whole buffer into the file
+
+        static std::string getFileName(std::string filePath); // Returns file name without its folder path and extension
+        static std::string getFolderPath(std::string filePath); // Returns path to the folder where file is located
+};
+
+// Read-only stream buffer over memory owned by someone else, so that file read into memory can be parsed without copying it
+class MemoryStreamBuffer : public std::streambuf
+{
+    public:
+        MemoryStreamBuffer(const char* data, size_t length); // Constructor
+    protected:
+        pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode mode); // Moves read position relatively
+        pos_type seekpos(pos_type position, std::ios_base::openmode mode); // Moves read position to specified position
 };
 
 #endif // IOADDONS_H
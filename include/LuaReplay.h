@@ -0,0 +1,45 @@
+#ifndef LUAREPLAY_H
+#define LUAREPLAY_H
+
+#include <string>
+#include <cstddef>
+
+struct lua_State;
+
+class LuaReplay
+{
+    public:
+        ~LuaReplay(); // Destructor
+
+        int runScript(std::string filePath, int mapWidth, int mapHeight); // Executes generated Lua script against an in-memory tile grid
+
+        double getParseTime(); // Returns time it took to compile the script (in milliseconds)
+        double getExecutionTime(); // Returns time it took to execute the script (in milliseconds)
+        size_t getPeakMemory(); // Returns peak memory used by the Lua interpreter (in bytes)
+        long long getSetTileCount(); // Returns number of settile commands the script has parsed
+        long long getOutOfBoundsCount(); // Returns number of settile commands which were outside of the map
+        int getTileFrame(int x, int y); // Returns tile frame set by the script on specified position
+        std::string getErrorMessage(); // Returns error message of the last failed run
+    private:
+        static void* allocate(void* userData, void* pointer, size_t oldSize, size_t newSize); // Memory allocator which keeps track of Lua memory usage
+        static int luaMap(lua_State* state); // Stub for CS2D map() function
+        static int luaParse(lua_State* state); // Stub for CS2D parse() function
+
+        void clearGrid(); // Removes the tile grid allocated on heap
+
+        // Map related variables
+        int mapWidth = 0; // Width of the map
+        int mapHeight = 0; // Height of the map
+        int** tileFrame = nullptr; // Tile frames set by the script
+
+        // Statistics
+        double parseTime = 0; // Time it took to compile the script
+        double executionTime = 0; // Time it took to execute the script
+        size_t currentMemory = 0; // Memory currently used by Lua
+        size_t peakMemory = 0; // Peak memory used by Lua
+        long long setTileCount = 0; // Number of settile commands
+        long long outOfBoundsCount = 0; // Number of settile commands outside of the map
+        std::string errorMessage; // Error message of the last failed run
+};
+
+#endif // LUAREPLAY_H
@@ -2,6 +2,7 @@
 #define MAPSYSTEM_H
 
 #include <string>
+#include <iostream>
 
 class MapSystem
 {
@@ -9,14 +10,25 @@ class MapSystem
         ~MapSystem(); // Destructor
 
         int loadMap(std::string filePath); // Loads map file from specified file
+        int loadMap(std::istream& file); // Loads map file from specified stream
         int unloadMap(); // Removes all the map data allocated on heap
         int saveMap(std::string filePath); // Saves map file to specified file
+        int saveMap(std::ostream& file); // Saves map file to specified stream
+        int saveMapToBuffer(std::string& buffer); // Saves map file into the in-memory buffer
 
         int generateLuaScript(std::string filePath); // Generates tile generation script in Lua and stores it into file
+        int generateLuaScript(std::ostream& file); // Generates tile generation script in Lua and writes it into stream
+        int generateLuaScriptToBuffer(std::string& buffer); // Generates tile generation script in Lua and stores it into the in-memory buffer
         int removeTiles(); // Removes tiles from currently loaded map
 
         std::string generateSpecialString(); // Returns special string used in saveMap() function
+
+        int getMapWidth(); // Returns width of the currently loaded map
+        int getMapHeight(); // Returns height of the currently loaded map
+        int getTileFrame(int x, int y); // Returns tile frame on specified position of the currently loaded map
     private:
+        void clearMapData(); // Removes all the map data allocated on heap, even if map was loaded only partially
+
         // Misc variables
         bool mapLoaded = false; // Is map loaded?
 
@@ -41,24 +53,24 @@ class MapSystem
         int backgroundColorRed; // Background red color value
         int backgroundColorGreen; // Background green color value
         int backgroundColorBlue; // Background blue color value
-        int* tileType; // Tile types
-        int** tileFrame; // Tile frames
-
-        int** tileModifier; // Tile modifiers
-        int** tileModificationFrame; // Tile modification frame
-        int** tileColorRed; // Tile red color value
-        int** tileColorGreen; // Tile green color value
-        int** tileColorBlue; // Tile blue color value
-        int** tileOverlayFrame; // Tile overlay frame
-
-        std::string* entityName; // Entity name input
-        std::string* entityTrigger; // Entity trigger input
-        int* entityType; // Entity type
-        int* entityX; // Entity x position
-        int* entityY; // Entity y position
-
-        int** entitySettingInt; // Entity settings ints
-        std::string** entitySettingString; // Entity setting strings
+        int* tileType = nullptr; // Tile types
+        int** tileFrame = nullptr; // Tile frames
+
+        int** tileModifier = nullptr; // Tile modifiers
+        int** tileModificationFrame = nullptr; // Tile modification frame
+        int** tileColorRed = nullptr; // Tile red color value
+        int** tileColorGreen = nullptr; // Tile green color value
+        int** tileColorBlue = nullptr; // Tile blue color value
+        int** tileOverlayFrame = nullptr; // Tile overlay frame
+
+        std::string* entityName = nullptr; // Entity name input
+        std::string* entityTrigger = nullptr; // Entity trigger input
+        int* entityType = nullptr; // Entity type
+        int* entityX = nullptr; // Entity x position
+        int* entityY = nullptr; // Entity y position
+
+        int** entitySettingInt = nullptr; // Entity settings ints
+        std::string** entitySettingString = nullptr; // Entity setting strings
 };
 
 #endif // MAPSYSTEM_H
@@ -0,0 +1,44 @@
+#ifndef MAPVALIDATOR_H
+#define MAPVALIDATOR_H
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <iostream>
+#include <cstdint>
+
+// Result of the validation of a single map
+struct MapValidation
+{
+    int result = 0; // Result code, see MapValidator::validateMap()
+    uint64_t offset = 0; // Byte offset where validation has stopped
+    uint64_t fileLength = 0; // Length of the map file
+    int mapWidth = 0; // Declared width of the map
+    int mapHeight = 0; // Declared height of the map
+    int entityCount = 0; // Declared number of entities
+};
+
+class MapValidator
+{
+    public:
+        static MapValidation validateMap(const std::string& data); // Checks structure of the map data without loading it
+        static std::string getResultName(int result); // Returns name of the result code, used in the report
+
+        int validateMaps(std::vector<std::string> mapPaths, int workerCount); // Checks all specified maps, returns number of invalid maps
+        MapValidation getResult(int index); // Returns result of the map with specified index
+        void writeReport(std::ostream& stream); // Writes report of the last validation, one JSON object per line
+    private:
+        static bool skipBytes(const std::string& data, uint64_t& position, uint64_t count); // Moves position by specified number of bytes
+        static bool skipString(const std::string& data, uint64_t& position); // Moves position past the next line break or to the end of the data
+        static bool readString(const std::string& data, uint64_t& position, std::string& value); // Reads a string up to line break
+        static bool readByte(const std::string& data, uint64_t& position, int& value); // Reads unsigned 8-bit byte
+        static bool readInt(const std::string& data, uint64_t& position, int& value); // Reads signed 32-bit integer
+
+        void validateFiles(); // Validation stage, runs on worker threads
+
+        std::vector<std::string> mapPaths; // Paths to the maps which are validated
+        std::vector<MapValidation> mapResults; // Results of the maps which are validated
+        std::atomic<size_t> nextMap; // Index of the next map which will be validated
+};
+
+#endif // MAPVALIDATOR_H
@@ -2,17 +2,132 @@
 #include <fstream>
 #include <string>
 #include <algorithm>
+#include <vector>
+#include <thread>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
 
 #include "IOAddons.h"
 #include "MapSystem.h"
+#include "BatchProcessor.h"
+#include "MapValidator.h"
 
 enum AppState {MAIN_MENU, EXIT, SELECT_FILE, SELECT_FILE_PROCEED, INFO_PROCEED, OPERATION};
 
 const std::string DATE_OF_COMPLETION = "08.05.2015";
 const std::string VERSION = "v2.0";
 
-int main()
+// Protects all the maps specified in the command line without any user interaction
+// Returns 0 if all maps were protected, 1 otherwise
+int runBatch(std::vector<std::string> mapPaths)
+{
+    int workerCount = std::thread::hardware_concurrency();
+    std::cout << "Protecting " << mapPaths.size() << " map(s) using " << std::max(workerCount, 1) << " worker(s)...\n";
+
+    BatchProcessor *batchProcessor = new BatchProcessor;
+    int failedCount = batchProcessor->run(mapPaths, workerCount);
+    for (size_t i = 0; i < mapPaths.size(); i++) {
+        int result = batchProcessor->getResult(i);
+        if (result == 0) {
+            std::cout << "Done: " << mapPaths[i] << "\n";
+        } else if (result == 1) {
+            std::cout << "Failed: " << mapPaths[i] << " (file could not be read)\n";
+        } else if (result == 2) {
+            std::cout << "Failed: " << mapPaths[i] << " (invalid map data)\n";
+        } else if (result == 4) {
+            std::cout << "Failed: " << mapPaths[i] << " (not enough memory)\n";
+        } else {
+            std::cout << "Failed: " << mapPaths[i] << " (generated files could not be written)\n";
+        }
+    }
+    delete batchProcessor;
+
+    std::cout << "\n" << mapPaths.size() - failedCount << " of " << mapPaths.size() << " map(s) were protected.\n";
+    return failedCount == 0 ? 0 : 1;
+}
+
+// Validates all the maps specified in the command line and prints a report, one JSON object per map
+// Returns 0 if all maps are valid, 1 otherwise
+int runValidation(std::vector<std::string> mapPaths)
+{
+    MapValidator *mapValidator = new MapValidator;
+    int invalidCount = mapValidator->validateMaps(mapPaths, std::thread::hardware_concurrency());
+    mapValidator->writeReport(std::cout);
+    delete mapValidator;
+
+    // Summary goes to stderr, so that stdout only contains the report
+    std::cerr << mapPaths.size() - invalidCount << " of " << mapPaths.size() << " map(s) are valid.\n";
+    return invalidCount == 0 ? 0 : 1;
+}
+
+// Protects a single map and writes one of the generated files into stdout instead of the map folder
+// Output can be either "lua" (Lua script) or "map" (tileless copy of the map)
+// Returns 0 if operation was successful, 1 otherwise
+int runStream(std::string output, std::string mapPath)
 {
+    if (output != "lua" && output != "map") {
+        std::cerr << "Unknown output \"" << output << "\", expected \"lua\" or \"map\".\n";
+        return 1;
+    }
+
+    MapSystem *mapSystem = new MapSystem;
+    int result = mapSystem->loadMap(mapPath);
+    if (result != 0) {
+        if (result == 2) {
+            std::cerr << "Specified file doesn't exist! (" << mapPath << ")\n";
+        } else if (result == 6) {
+            std::cerr << "There is not enough memory to load the specified map file! (" << mapPath << ")\n";
+        } else {
+            std::cerr << "Specified map file contains invalid map data! (" << mapPath << ")\n";
+        }
+        delete mapSystem;
+        return 1;
+    }
+
+    // Generated file is written straight into stdout, without keeping a copy of it in memory
+    if (output == "lua") {
+        mapSystem->generateLuaScript(std::cout); // stdout stays in text mode, same as the .lua file
+    } else {
+        if (mapSystem->removeTiles() != 0) {
+            std::cerr << "There is not enough memory to remove the tiles!\n";
+            delete mapSystem;
+            return 1;
+        }
+#ifdef _WIN32
+        _setmode(_fileno(stdout), _O_BINARY); // Line breaks must not be converted in the .map file
+#endif
+        mapSystem->saveMap(std::cout);
+    }
+    delete mapSystem;
+
+    std::cout.flush();
+    return std::cout.fail() ? 1 : 0;
+}
+
+int main(int argc, char* argv[])
+{
+    // If --validate is specified, only check the maps and exit
+    if (argc > 1 && std::string(argv[1]) == "--validate") {
+        return runValidation(std::vector<std::string>(argv + 2, argv + argc));
+    }
+
+    // If --stdout is specified, write the generated file into stdout so that it can be piped into another application
+    if (argc > 1 && std::string(argv[1]) == "--stdout") {
+        if (argc != 4) {
+            std::cerr << "Usage: " << argv[0] << " --stdout <lua|map> <map file>\n";
+            return 1;
+        }
+        return runStream(argv[2], argv[3]);
+    }
+
+    // If maps are specified in the command line, protect them all at once and exit
+    if (argc > 1) {
+        return runBatch(std::vector<std::string>(argv + 1, argv + argc));
+    }
+
     MapSystem *mapSystem = new MapSystem;
 
     int appState = MAIN_MENU;
@@ -90,9 +205,13 @@ int main()
             std::transform(input.begin(), input.end(), input.begin(), ::tolower);
             if (input == "y") {
                 // Checking if map file is valid as well as loading the map itself
-                if (mapSystem->loadMap(mapPath) == 0) {
+                int result = mapSystem->loadMap(mapPath);
+                if (result == 0) {
                     appState = INFO_PROCEED;
                     std::cout << "\n";
+                } else if (result == 6) {
+                    appState = SELECT_FILE;
+                    std::cout << "\nThere is not enough memory to load the specified map file!\n\n";
                 } else {
                     appState = SELECT_FILE;
                     std::cout << "\nSpecified map file contains invalid map data!\n\n";
@@ -139,22 +258,10 @@ int main()
         } else if (appState == OPERATION) {
             // Operation of generating the tileless map and Lua script
             // Getting rid of full path and extension to leave out map name only
-            std::string name = mapPath;
-            if (name.find_last_of("\\/") != std::string::npos) {
-                name.erase(0, name.find_last_of("\\/") + 1);
-            }
-
-            if (name.find_last_of(".") != std::string::npos) {
-                name.erase(name.find_last_of("."));
-            }
+            std::string name = IOAddons::getFileName(mapPath);
 
             // Getting path to the folder where map file is located
-            std::string folderPath = mapPath;
-            if (folderPath.find_last_of("\\/") != std::string::npos) {
-                folderPath.erase(folderPath.find_last_of("\\/")+1);
-            } else {
-                folderPath = "";
-            }
+            std::string folderPath = IOAddons::getFolderPath(mapPath);
 
             // Generating Lua script
             std::cout << "Generating the Lua script...\n";
@@ -162,14 +269,18 @@ int main()
             std::cout << "Done! Saved as \"" << name << " (Map generation script).lua\".\n\n";
 
             // Generating tileless copy of the map
+            // If tiles can't be removed, the map is not saved at all, since it would still contain every tile
             std::cout << "Generating a tileless copy of the map...\n";
-            mapSystem->removeTiles();
-            mapSystem->saveMap(folderPath + name + " (Tileless version).map");
-            std::cout << "Done! Saved as \"" << name << " (Tileless version).map\".\n";
+            if (mapSystem->removeTiles() == 0) {
+                mapSystem->saveMap(folderPath + name + " (Tileless version).map");
+                std::cout << "Done! Saved as \"" << name << " (Tileless version).map\".\n";
+                std::cout << "\nOperation was successful!\n\n";
+            } else {
+                std::cout << "\nThere is not enough memory to remove the tiles! Tileless copy was not saved.\n\n";
+            }
 
             mapSystem->unloadMap(); // Unloading the currently loaded map
             appState = MAIN_MENU; // Sending user back to main menu
-            std::cout << "\nOperation was successful!\n\n";
         }
     }
 
@@ -0,0 +1,63 @@
+#include <iostream>
+#include <string>
+
+#include "MapSystem.h"
+#include "LuaReplay.h"
+
+// Headless replay of the generated Lua script
+// Usage: replay <path to .map file> <path to generated .lua script>
+// The .map file should be the original (not tileless) map, it is used to get the map sizes and to verify the result
+int main(int argc, char* argv[])
+{
+    if (argc < 3) {
+        std::cout << "Usage: " << argv[0] << " <map file> <Lua script>\n";
+        return 1;
+    }
+
+    std::string mapPath = argv[1];
+    std::string scriptPath = argv[2];
+
+    // Loading the original map
+    MapSystem *mapSystem = new MapSystem;
+    if (mapSystem->loadMap(mapPath) != 0) {
+        std::cout << "Specified map file contains invalid map data! (" << mapPath << ")\n";
+        delete mapSystem;
+        return 1;
+    }
+
+    // Executing the script
+    LuaReplay *luaReplay = new LuaReplay;
+    int result = luaReplay->runScript(scriptPath, mapSystem->getMapWidth(), mapSystem->getMapHeight());
+    if (result != 0) {
+        std::cout << "Script has failed! (" << luaReplay->getErrorMessage() << ")\n";
+        delete luaReplay;
+        delete mapSystem;
+        return 1;
+    }
+
+    // Comparing the tiles set by the script with the original map
+    long long mismatchCount = 0;
+    for (int x = 0; x <= mapSystem->getMapWidth(); x++) {
+        for (int y = 0; y <= mapSystem->getMapHeight(); y++) {
+            if (luaReplay->getTileFrame(x, y) != mapSystem->getTileFrame(x, y)) {
+                mismatchCount++;
+            }
+        }
+    }
+
+    // Printing out the report
+    std::cout << "map: " << mapPath << "\n";
+    std::cout << "script: " << scriptPath << "\n";
+    std::cout << "map_size: " << mapSystem->getMapWidth() + 1 << "x" << mapSystem->getMapHeight() + 1 << "\n";
+    std::cout << "parse_time_ms: " << luaReplay->getParseTime() << "\n";
+    std::cout << "execution_time_ms: " << luaReplay->getExecutionTime() << "\n";
+    std::cout << "peak_lua_memory_bytes: " << luaReplay->getPeakMemory() << "\n";
+    std::cout << "settile_calls: " << luaReplay->getSetTileCount() << "\n";
+    std::cout << "settile_out_of_bounds: " << luaReplay->getOutOfBoundsCount() << "\n";
+    std::cout << "tile_mismatches: " << mismatchCount << "\n";
+
+    delete luaReplay;
+    delete mapSystem;
+
+    return mismatchCount == 0 ? 0 : 2;
+}
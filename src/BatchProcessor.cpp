@@ -0,0 +1,173 @@
+#include "BatchProcessor.h"
+#include "MapSystem.h"
+#include "IOAddons.h"
+
+#include <istream>
+#include <new>
+#include <exception>
+#include <thread>
+
+BatchQueue::BatchQueue(size_t capacity) {
+    this->capacity = capacity;
+}
+
+void BatchQueue::push(BatchJob* job) {
+    std::unique_lock<std::mutex> lock(mutex);
+    notFull.wait(lock, [this] { return jobs.size() < capacity; }); // Waits until there is space in the queue
+    jobs.push_back(job);
+    notEmpty.notify_one();
+}
+
+BatchJob* BatchQueue::pop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    notEmpty.wait(lock, [this] { return !jobs.empty() || closed; }); // Waits until there is a job or queue is closed
+    if (jobs.empty()) {
+        return nullptr; // Queue is closed and there are no more jobs
+    }
+
+    BatchJob* job = jobs.front();
+    jobs.pop_front();
+    notFull.notify_one();
+    return job;
+}
+
+void BatchQueue::close() {
+    std::unique_lock<std::mutex> lock(mutex);
+    closed = true;
+    notEmpty.notify_all();
+}
+
+// Following function will protect all specified maps, same as the OPERATION state of the application does
+// Reading and writing of the files is done on separate I/O threads, so that workers never wait for the disk
+// Queues between the stages hold up to two maps per worker, so that next maps are already read while current ones are processed
+// Returns number of maps which have failed
+int BatchProcessor::run(std::vector<std::string> mapPaths, int workerCount) {
+    if (workerCount < 1) {
+        workerCount = 1;
+    }
+
+    this->mapPaths = mapPaths;
+    mapResults.assign(mapPaths.size(), 0);
+    inputQueue = new BatchQueue(workerCount * 2);
+    outputQueue = new BatchQueue(workerCount * 2);
+
+    // Starting the pipeline
+    std::thread reader(&BatchProcessor::readMaps, this);
+    std::thread writer(&BatchProcessor::writeMaps, this);
+    std::vector<std::thread> workers;
+    for (int i = 0; i < workerCount; i++) {
+        workers.push_back(std::thread(&BatchProcessor::processMaps, this));
+    }
+
+    // Waiting for the pipeline to finish
+    reader.join();
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+    outputQueue->close(); // All workers are done, nothing else will be written
+    writer.join();
+
+    delete inputQueue;
+    delete outputQueue;
+    inputQueue = nullptr;
+    outputQueue = nullptr;
+
+    int failedCount = 0;
+    for (size_t i = 0; i < mapResults.size(); i++) {
+        if (mapResults[i] != 0) {
+            failedCount++;
+        }
+    }
+    return failedCount;
+}
+
+// Returns result of the map with specified index
+// Returns 0 if map was protected successfully
+// Returns 1 if map file was not read (failure)
+// Returns 2 if map file contains invalid map data (failure)
+// Returns 3 if generated files were not written (failure)
+// Returns 4 if there is not enough memory to read, load or protect the map (failure)
+int BatchProcessor::getResult(int index) {
+    return mapResults[index];
+}
+
+// Reads map files one by one and passes them to the workers
+void BatchProcessor::readMaps() {
+    for (size_t i = 0; i < mapPaths.size(); i++) {
+        BatchJob* job = nullptr;
+        try {
+            job = new BatchJob;
+            job->index = i;
+            int result = IOAddons::readFile(mapPaths[i], job->mapData);
+            if (result != 0) {
+                mapResults[i] = result == 3 ? 4 : 1; // Map file wasn't read or there is not enough memory
+                delete job;
+                continue;
+            }
+        } catch (std::bad_alloc&) {
+            mapResults[i] = 4; // Not enough memory to read the map
+            delete job;
+            continue;
+        } catch (std::exception&) {
+            mapResults[i] = 1; // Map file wasn't read, exception must not leave the reader thread
+            delete job;
+            continue;
+        }
+        inputQueue->push(job);
+    }
+    inputQueue->close(); // All maps were read
+}
+
+// Generates Lua script and tileless copy of the map in memory
+void BatchProcessor::processMaps() {
+    MapSystem mapSystem;
+    BatchJob* job;
+    while ((job = inputQueue->pop()) != nullptr) {
+        // Prefetched map data is parsed in place, without copying it into a string stream
+        MemoryStreamBuffer mapBuffer(job->mapData.data(), job->mapData.length());
+        std::istream mapStream(&mapBuffer);
+        int result = mapSystem.loadMap(mapStream);
+        std::string().swap(job->mapData); // Source map data is not needed anymore
+
+        if (result != 0) {
+            mapResults[job->index] = result == 6 ? 4 : 2; // Map file contains invalid map data or there is not enough memory
+            delete job;
+            continue;
+        }
+
+        // Generating Lua script and tileless copy of the map
+        // Every step reports running out of memory through its return code, exception is caught just in case
+        bool generated = false;
+        try {
+            generated = mapSystem.generateLuaScriptToBuffer(job->luaScript) == 0
+                    && mapSystem.removeTiles() == 0
+                    && mapSystem.saveMapToBuffer(job->tilelessMap) == 0;
+        } catch (std::bad_alloc&) {
+            generated = false;
+        }
+
+        mapSystem.unloadMap(); // Unloading the map so that the next one can be loaded
+        if (!generated) {
+            mapResults[job->index] = 4; // Not enough memory to generate the files
+            delete job;
+            continue;
+        }
+        outputQueue->push(job);
+    }
+}
+
+// Writes generated files next to the source map files
+void BatchProcessor::writeMaps() {
+    BatchJob* job;
+    while ((job = outputQueue->pop()) != nullptr) {
+        std::string name = IOAddons::getFileName(mapPaths[job->index]);
+        std::string folderPath = IOAddons::getFolderPath(mapPaths[job->index]);
+
+        // Lua script is written in text mode, same as generateLuaScript() does
+        if (IOAddons::writeFile(folderPath + name + " (Map generation script).lua", job->luaScript, false) != 0
+                || IOAddons::writeFile(folderPath + name + " (Tileless version).map", job->tilelessMap, true) != 0) {
+            mapResults[job->index] = 3; // Generated files weren't written
+        }
+        delete job;
+    }
+}
@@ -4,49 +4,51 @@
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <new>
+#include <stdexcept>
 
 // See header file for more information on the functions!
 
-void IOAddons::writeByte(std::ofstream& file, int8_t value) {
+void IOAddons::writeByte(std::ostream& file, int8_t value) {
     file.write(reinterpret_cast<const char*>(&value), sizeof(value));
 }
 
-void IOAddons::writeShort(std::ofstream& file, int16_t value) {
+void IOAddons::writeShort(std::ostream& file, int16_t value) {
     file.write(reinterpret_cast<const char*>(&value), sizeof(value));
 }
 
-void IOAddons::writeInt(std::ofstream& file, int32_t value) {
+void IOAddons::writeInt(std::ostream& file, int32_t value) {
     file.write(reinterpret_cast<const char*>(&value), sizeof(value));
 }
 
-void IOAddons::writeString(std::ofstream& file, std::string value) {
+void IOAddons::writeString(std::ostream& file, std::string value) {
     std::string returnString = value;
     returnString.insert(returnString.length(), "\r\n");
     file << (returnString);
 }
 
-int IOAddons::readByte(std::ifstream& file) {
-    int8_t returnValue;
+int IOAddons::readByte(std::istream& file) {
+    int8_t returnValue = 0; // Stays 0 if reading has failed
     file.read((char*)&returnValue, sizeof(returnValue));
 
-    return (unsigned int8_t)returnValue;
+    return (uint8_t)returnValue;
 }
 
-int IOAddons::readShort(std::ifstream& file) {
-    int16_t returnValue;
+int IOAddons::readShort(std::istream& file) {
+    int16_t returnValue = 0; // Stays 0 if reading has failed
     file.read((char*)&returnValue, sizeof(returnValue));
 
-    return (unsigned int16_t)returnValue;
+    return (uint16_t)returnValue;
 }
 
-int IOAddons::readInt(std::ifstream& file) {
-    int32_t returnValue;
+int IOAddons::readInt(std::istream& file) {
+    int32_t returnValue = 0; // Stays 0 if reading has failed
     file.read((char*)&returnValue, sizeof(returnValue));
 
     return returnValue;
 }
 
-std::string IOAddons::readString(std::ifstream& file) {
+std::string IOAddons::readString(std::istream& file) {
     std::string returnString;
     std::getline(file, returnString);
 
@@ -55,3 +57,115 @@ std::string IOAddons::readString(std::ifstream& file) {
 
     return returnString;
 }
+
+uint64_t IOAddons::getRemainingLength(std::istream& file) {
+    if (!file.good()) {
+        return 0; // Nothing can be read from a failed stream or stream which has reached its end
+    }
+
+    std::streampos position = file.tellg();
+    if (position == std::streampos(-1)) {
+        return UINT64_MAX; // Stream can't be seeked (pipe, for example), so its length is unknown
+    }
+    file.seekg(0, std::ios::end);
+    std::streampos end = file.tellg();
+    file.seekg(position);
+
+    return (uint64_t)(end - position);
+}
+
+int IOAddons::readFile(std::string filePath, std::string& buffer) {
+    std::ifstream file(filePath, std::ios::binary | std::ios::ate); // Opening input stream at the end to get file size
+    if (file.fail()) {
+        return 1; // File wasn't found
+    }
+
+    std::streamoff fileSize = file.tellg();
+    if (fileSize < 0) {
+        return 2; // Size is unknown (directory or stream which can't be seeked), file can't be read completely
+    }
+    file.seekg(0, std::ios::beg);
+    try {
+        buffer.resize(fileSize);
+    } catch (std::bad_alloc&) {
+        return 3; // Not enough memory to read the file
+    } catch (std::length_error&) {
+        return 2; // Reported size is not a real file size (directory, for example), file can't be read completely
+    }
+    if (fileSize > 0) {
+        file.read(&buffer[0], fileSize);
+    }
+
+    if (file.fail()) {
+        return 2; // File wasn't read completely
+    }
+    return 0;
+}
+
+int IOAddons::writeFile(std::string filePath, const std::string& buffer, bool binary) {
+    std::ofstream file(filePath, binary ? std::ios::binary : std::ios::out); // Opening output stream
+    if (file.fail()) {
+        return 1; // File wasn't opened
+    }
+
+    file.write(buffer.data(), buffer.length());
+
+    if (file.fail()) {
+        return 2; // File wasn't written completely
+    }
+    return 0;
+}
+
+std::string IOAddons::getFileName(std::string filePath) {
+    std::string name = filePath;
+    if (name.find_last_of("\\/") != std::string::npos) {
+        name.erase(0, name.find_last_of("\\/") + 1);
+    }
+
+    if (name.find_last_of(".") != std::string::npos) {
+        name.erase(name.find_last_of("."));
+    }
+
+    return name;
+}
+
+std::string IOAddons::getFolderPath(std::string filePath) {
+    std::string folderPath = filePath;
+    if (folderPath.find_last_of("\\/") != std::string::npos) {
+        folderPath.erase(folderPath.find_last_of("\\/")+1);
+    } else {
+        folderPath = "";
+    }
+
+    return folderPath;
+}
+
+MemoryStreamBuffer::MemoryStreamBuffer(const char* data, size_t length) {
+    char* begin = const_cast<char*>(data); // Buffer is only read from, std::streambuf just doesn't have a const version
+    setg(begin, begin, begin + length);
+}
+
+MemoryStreamBuffer::pos_type MemoryStreamBuffer::seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode mode) {
+    if (!(mode & std::ios_base::in)) {
+        return pos_type(off_type(-1)); // Buffer can't be written to
+    }
+
+    char* base = eback();
+    if (direction == std::ios_base::cur) {
+        base = gptr();
+    } else if (direction == std::ios_base::end) {
+        base = egptr();
+    }
+
+    off_type position = (base - eback()) + offset;
+    if (position < 0 || position > egptr() - eback()) {
+        return pos_type(off_type(-1)); // Position is outside of the buffer
+    }
+    setg(eback(), eback() + position, egptr());
+
+    return pos_type(position);
+}
+
+MemoryStreamBuffer::pos_type MemoryStreamBuffer::seekpos(pos_type position, std::ios_base::openmode mode) {
+    return seekoff(off_type(position), std::ios_base::beg, mode);
+}
@@ -0,0 +1,205 @@
+#include "LuaReplay.h"
+
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+extern "C" {
+    #include <lua.h>
+    #include <lauxlib.h>
+    #include <lualib.h>
+}
+
+LuaReplay::~LuaReplay() {
+    clearGrid(); // Removes any heap allocated memory
+}
+
+// Following function will execute the generated Lua script in a local Lua interpreter
+// CS2D functions map() and parse() are stubbed, settile commands are applied to an in-memory grid
+// Returns 0 if operation was successful
+// Returns 1 if script file was not found (failure)
+// Returns 2 if Lua state could not be created (failure)
+// Returns 3 if script has failed to compile (failure)
+// Returns 4 if script has failed during execution (failure)
+int LuaReplay::runScript(std::string filePath, int mapWidth, int mapHeight) {
+    std::ifstream file(filePath, std::ios::binary); // Opening input stream
+    if (file.fail()) { // Checks if file stream was successfully opened
+        errorMessage = "Script file was not found";
+        return 1; // Script file wasn't found; operation failed
+    }
+
+    // Reading the whole script into memory so that file reading isn't measured
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string script = buffer.str();
+
+    // Setting up the tile grid
+    clearGrid();
+    this->mapWidth = mapWidth;
+    this->mapHeight = mapHeight;
+    tileFrame = new int*[mapWidth+1];
+    for (int x = 0; x <= mapWidth; x++) {
+        tileFrame[x] = new int[mapHeight+1](); // Every tile defaults to 0
+    }
+
+    // Resetting statistics
+    parseTime = 0;
+    executionTime = 0;
+    currentMemory = 0;
+    peakMemory = 0;
+    setTileCount = 0;
+    outOfBoundsCount = 0;
+    errorMessage = "";
+
+    lua_State* state = lua_newstate(allocate, this); // Creating Lua state with memory tracking allocator
+    if (state == NULL) {
+        errorMessage = "Lua state could not be created";
+        return 2; // Lua state wasn't created; operation failed
+    }
+    luaL_openlibs(state);
+
+    // Registering CS2D function stubs
+    lua_pushlightuserdata(state, this);
+    lua_pushcclosure(state, luaMap, 1);
+    lua_setglobal(state, "map");
+    lua_pushlightuserdata(state, this);
+    lua_pushcclosure(state, luaParse, 1);
+    lua_setglobal(state, "parse");
+
+    // Compiling the script
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    int result = luaL_loadbuffer(state, script.c_str(), script.length(), ("@" + filePath).c_str());
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    parseTime = std::chrono::duration<double, std::milli>(end - start).count();
+    if (result != 0) {
+        const char* message = lua_tostring(state, -1); // Error value doesn't have to be a string
+        errorMessage = message != NULL ? message : "(non-string error)";
+        lua_close(state);
+        return 3; // Script wasn't compiled; operation failed
+    }
+
+    // Executing the script
+    start = std::chrono::steady_clock::now();
+    result = lua_pcall(state, 0, 0, 0);
+    end = std::chrono::steady_clock::now();
+    executionTime = std::chrono::duration<double, std::milli>(end - start).count();
+    if (result != 0) {
+        const char* message = lua_tostring(state, -1); // Error value doesn't have to be a string
+        errorMessage = message != NULL ? message : "(non-string error)";
+        lua_close(state);
+        return 4; // Script has failed during execution; operation failed
+    }
+
+    lua_close(state);
+
+    return 0; // Script was executed, operation was successful
+}
+
+// Returns time it took to compile the script (in milliseconds)
+double LuaReplay::getParseTime() {
+    return parseTime;
+}
+
+// Returns time it took to execute the script (in milliseconds)
+double LuaReplay::getExecutionTime() {
+    return executionTime;
+}
+
+// Returns peak memory used by the Lua interpreter (in bytes)
+size_t LuaReplay::getPeakMemory() {
+    return peakMemory;
+}
+
+// Returns number of settile commands the script has parsed
+long long LuaReplay::getSetTileCount() {
+    return setTileCount;
+}
+
+// Returns number of settile commands which were outside of the map
+long long LuaReplay::getOutOfBoundsCount() {
+    return outOfBoundsCount;
+}
+
+// Returns tile frame set by the script on specified position
+// Returns 0 if position is outside of the map
+int LuaReplay::getTileFrame(int x, int y) {
+    if (tileFrame != nullptr && x >= 0 && x <= mapWidth && y >= 0 && y <= mapHeight) {
+        return tileFrame[x][y];
+    } else {
+        return 0;
+    }
+}
+
+// Returns error message of the last failed run
+std::string LuaReplay::getErrorMessage() {
+    return errorMessage;
+}
+
+// Memory allocator which is passed to Lua, works the same way as the default one but keeps track of memory usage
+void* LuaReplay::allocate(void* userData, void* pointer, size_t oldSize, size_t newSize) {
+    LuaReplay* replay = static_cast<LuaReplay*>(userData);
+    if (pointer == NULL) { // If pointer is NULL, oldSize contains type of the object instead of its size
+        oldSize = 0;
+    }
+
+    if (newSize == 0) {
+        std::free(pointer);
+        replay->currentMemory -= oldSize;
+        return NULL;
+    }
+
+    void* newPointer = std::realloc(pointer, newSize);
+    if (newPointer != NULL) {
+        replay->currentMemory += newSize - oldSize;
+        if (replay->currentMemory > replay->peakMemory) {
+            replay->peakMemory = replay->currentMemory;
+        }
+    }
+    return newPointer;
+}
+
+// Stub for CS2D map() function, only map sizes are supported
+int LuaReplay::luaMap(lua_State* state) {
+    LuaReplay* replay = static_cast<LuaReplay*>(lua_touserdata(state, lua_upvalueindex(1)));
+    std::string value = luaL_checkstring(state, 1);
+
+    if (value == "xsize") {
+        lua_pushinteger(state, replay->mapWidth);
+    } else if (value == "ysize") {
+        lua_pushinteger(state, replay->mapHeight);
+    } else {
+        lua_pushinteger(state, 0);
+    }
+    return 1;
+}
+
+// Stub for CS2D parse() function, only settile command is applied, everything else is ignored
+int LuaReplay::luaParse(lua_State* state) {
+    LuaReplay* replay = static_cast<LuaReplay*>(lua_touserdata(state, lua_upvalueindex(1)));
+    const char* command = luaL_checkstring(state, 1);
+
+    int x, y, frame;
+    if (std::sscanf(command, "settile %d %d %d", &x, &y, &frame) == 3) {
+        replay->setTileCount++;
+        if (x >= 0 && x <= replay->mapWidth && y >= 0 && y <= replay->mapHeight) {
+            replay->tileFrame[x][y] = frame; // Applying the tile
+        } else {
+            replay->outOfBoundsCount++;
+        }
+    }
+    return 0;
+}
+
+// Removes the tile grid allocated on heap
+void LuaReplay::clearGrid() {
+    if (tileFrame != nullptr) {
+        for (int x = 0; x <= mapWidth; x++) {
+            delete[] tileFrame[x];
+        }
+        delete[] tileFrame;
+        tileFrame = nullptr;
+    }
+}
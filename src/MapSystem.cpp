@@ -3,9 +3,13 @@
 
 #include <fstream>
 #include <iostream>
+#include <sstream>
 #include <ctime>
 #include <cstdio>
 #include <cstdint>
+#include <mutex>
+#include <new>
+#include <vector>
 #include <windows.h>
 
 MapSystem::~MapSystem() {
@@ -21,48 +25,79 @@ MapSystem::~MapSystem() {
 // Returns 2 if map file was not found (failure)
 // Returns 3 if map has failed first header check (failure)
 // Returns 4 if map has failed second header check (failure)
+// Returns 5 if map file ends early or declared map sizes or entity count don't fit in the file (failure)
+// Returns 6 if there is not enough memory to load the map (failure)
 int MapSystem::loadMap(std::string filePath) {
     if (!(mapLoaded)) {
         std::ifstream file(filePath, std::ios::binary); // Opening input stream
         if (!file.fail()) { // Checks if file stream was successfully opened
-            if (IOAddons::readString(file) == "Unreal Software's Counter-Strike 2D Map File (max)") { // First header check
-                // Byte settings
-                scrollMapLikeTiles = IOAddons::readByte(file); // Will map scroll like tiles?
-                useModifiers = IOAddons::readByte(file); // Will map use modifiers?
-                for (int i = 0; i < 8; i++) { // Skips through unused settings bytes
-                    IOAddons::readByte(file);
-                }
+            return loadMap(file);
+        } else {
+            return 2; // Map file wasn't found; operation failed
+        }
+    } else {
+        return 1; // Map is already loaded; operation failed
+    }
+}
+
+// Following function will load map data from a stream (for example, map file which was already read into memory)
+// Stream has to be opened in binary mode
+// Returns the same values as the function above, with the exception of 2
+int MapSystem::loadMap(std::istream& file) {
+    if (!(mapLoaded)) {
+        if (IOAddons::readString(file) == "Unreal Software's Counter-Strike 2D Map File (max)") { // First header check
+            // Byte settings
+            scrollMapLikeTiles = IOAddons::readByte(file); // Will map scroll like tiles?
+            useModifiers = IOAddons::readByte(file); // Will map use modifiers?
+            for (int i = 0; i < 8; i++) { // Skips through unused settings bytes
+                IOAddons::readByte(file);
+            }
+
+            // Int settings
+            upTime = IOAddons::readInt(file); // Gets up time of the system when map was created
+            USGNID = IOAddons::readInt(file); // Gets USGN ID of the author
+            if (USGNID > 0) { // If USGN ID is not 0, then user was registered
+                USGNID -= 51; // USGN ID has an offset of +51 (or 0 if he was not registered)
+            }
+            for (int i = 0; i < 8; i++) { // Skips through unused settings ints
+                IOAddons::readInt(file);
+            }
 
-                // Int settings
-                upTime = IOAddons::readInt(file); // Gets up time of the system when map was created
-                USGNID = IOAddons::readInt(file); // Gets USGN ID of the author
-                if (USGNID > 0) { // If USGN ID is not 0, then user was registered
-                    USGNID -= 51; // USGN ID has an offset of +51 (or 0 if he was not registered)
+            // String settings
+            authorName = IOAddons::readString(file);  // Gets author username he used during the creation of the map
+            for (int i = 0; i < 9; i++) { // Skips through unused settings strings
+                IOAddons::readString(file);
+            }
+
+            // More map settings
+            IOAddons::readString(file); // Reads special string which is not used in this application so it isn't saved
+            tilesetFileName = IOAddons::readString(file); // Gets tileset filename
+            requiredTilesCount = IOAddons::readByte(file); // Gets count of required tiles
+            mapWidth = IOAddons::readInt(file); // Gets map width
+            mapHeight = IOAddons::readInt(file); // Gets map height
+            backgroundFileName = IOAddons::readString(file); // Gets background filename
+            mapScrollXSpeed = IOAddons::readInt(file); // Gets map scroll x speed
+            mapScrollYSpeed = IOAddons::readInt(file); // Gets map scroll y speed
+            backgroundColorRed = IOAddons::readByte(file); // Gets background red color
+            backgroundColorGreen = IOAddons::readByte(file); // Gets background green color
+            backgroundColorBlue = IOAddons::readByte(file); // Gets background blue color
+
+            if (IOAddons::readString(file) == "ed.erawtfoslaernu") { // Second header check
+                // Checking declared map sizes before anything is allocated
+                // Sizes are computed in 64-bit, so that huge or corrupted maps can't overflow them
+                if (mapWidth < 0 || mapHeight < 0 || mapWidth == INT32_MAX || mapHeight == INT32_MAX) {
+                    return 5; // Map sizes are invalid; operation failed
                 }
-                for (int i = 0; i < 8; i++) { // Skips through unused settings ints
-                    IOAddons::readInt(file);
+                uint64_t tileCount = (uint64_t)(mapWidth + 1) * (uint64_t)(mapHeight + 1); // Number of tiles in the map
+                uint64_t minimumLength = (requiredTilesCount + 1) + tileCount + 4; // Tile types, tile frames and entity count
+                if (useModifiers == 1) {
+                    minimumLength += tileCount; // Every tile has at least one modifier byte
                 }
-
-                // String settings
-                authorName = IOAddons::readString(file);  // Gets author username he used during the creation of the map
-                for (int i = 0; i < 9; i++) { // Skips through unused settings strings
-                    IOAddons::readString(file);
+                if (tileCount > SIZE_MAX / sizeof(int) || minimumLength > IOAddons::getRemainingLength(file)) {
+                    return 5; // Map sizes don't match the file length; operation failed
                 }
 
-                // More map settings
-                IOAddons::readString(file); // Reads special string which is not used in this application so it isn't saved
-                tilesetFileName = IOAddons::readString(file); // Gets tileset filename
-                requiredTilesCount = IOAddons::readByte(file); // Gets count of required tiles
-                mapWidth = IOAddons::readInt(file); // Gets map width
-                mapHeight = IOAddons::readInt(file); // Gets map height
-                backgroundFileName = IOAddons::readString(file); // Gets background filename
-                mapScrollXSpeed = IOAddons::readInt(file); // Gets map scroll x speed
-                mapScrollYSpeed = IOAddons::readInt(file); // Gets map scroll y speed
-                backgroundColorRed = IOAddons::readByte(file); // Gets background red color
-                backgroundColorGreen = IOAddons::readByte(file); // Gets background green color
-                backgroundColorBlue = IOAddons::readByte(file); // Gets background blue color
-
-                if (IOAddons::readString(file) == "ed.erawtfoslaernu") { // Second header check
+                try {
                     // Tile types
                     tileType = new int[requiredTilesCount+1];
                     for (int i = 0; i <= requiredTilesCount; i++) {
@@ -70,7 +105,7 @@ int MapSystem::loadMap(std::string filePath) {
                     }
 
                     // Tile frames
-                    tileFrame = new int*[mapWidth+1]; // Setting up array to store tile frame
+                    tileFrame = new int*[mapWidth+1](); // Setting up array to store tile frame
                     for (int x = 0; x <= mapWidth; x++) {
                         tileFrame[x] = new int[mapHeight+1]; // Adding a second dimension to declared array
                         for (int y = 0; y <= mapHeight; y++) {
@@ -82,21 +117,21 @@ int MapSystem::loadMap(std::string filePath) {
                     if (useModifiers == 1) {
 
                         // Setting up arrays to store modifier data
-                        tileModifier = new int*[mapWidth+1];
-                        tileModificationFrame = new int*[mapWidth+1];
-                        tileColorRed = new int*[mapWidth+1];
-                        tileColorGreen = new int*[mapWidth+1];
-                        tileColorBlue = new int*[mapWidth+1];
-                        tileOverlayFrame = new int*[mapWidth+1];
+                        tileModifier = new int*[mapWidth+1]();
+                        tileModificationFrame = new int*[mapWidth+1]();
+                        tileColorRed = new int*[mapWidth+1]();
+                        tileColorGreen = new int*[mapWidth+1]();
+                        tileColorBlue = new int*[mapWidth+1]();
+                        tileOverlayFrame = new int*[mapWidth+1]();
                         for (int x = 0; x <= mapWidth; x++) {
 
-                            // Adding a second dimension to declared arrays
-                            tileModifier[x] = new int[mapHeight+1];
-                            tileModificationFrame[x] = new int[mapHeight+1];
-                            tileColorRed[x] = new int[mapHeight+1];
-                            tileColorGreen[x] = new int[mapHeight+1];
-                            tileColorBlue[x] = new int[mapHeight+1];
-                            tileOverlayFrame[x] = new int[mapHeight+1];
+                            // Adding a second dimension to declared arrays, every value defaults to 0
+                            tileModifier[x] = new int[mapHeight+1]();
+                            tileModificationFrame[x] = new int[mapHeight+1]();
+                            tileColorRed[x] = new int[mapHeight+1]();
+                            tileColorGreen[x] = new int[mapHeight+1]();
+                            tileColorBlue[x] = new int[mapHeight+1]();
+                            tileOverlayFrame[x] = new int[mapHeight+1]();
                             for (int y = 0; y <= mapHeight; y++) {
                                 tileModifier[x][y] = IOAddons::readByte(file); // Gets tile modifier
                                 int modifier = tileModifier[x][y]; // Variable for shorter usage
@@ -106,16 +141,11 @@ int MapSystem::loadMap(std::string filePath) {
                                         IOAddons::readString(file); // Reads unused string
                                     } else if ((modifier & 64) || !(modifier & 128)) {
                                         tileModificationFrame[x][y] = IOAddons::readByte(file); // Gets modification frame of that tile
-                                        tileColorRed[x][y] = 0;
-                                        tileColorGreen[x][y] = 0;
-                                        tileColorBlue[x][y] = 0;
-                                        tileOverlayFrame[x][y] = 0;
                                     } else {
                                         tileColorRed[x][y] = IOAddons::readByte(file); // Gets red color value of that tile
                                         tileColorGreen[x][y] = IOAddons::readByte(file); // Gets green color value of that tile
                                         tileColorBlue[x][y] = IOAddons::readByte(file); // Gets blue color value of that tile
                                         tileOverlayFrame[x][y] = IOAddons::readByte(file); // Gets overlay frame of that tile
-                                        tileModificationFrame[x][y] = 0;
                                     }
                                 }
                             }
@@ -125,6 +155,13 @@ int MapSystem::loadMap(std::string filePath) {
                     // Entities
                     entityCount = IOAddons::readInt(file); // Gets a number of entities used in the map
 
+                    // Checking declared entity count, every entity takes at least 61 bytes in the file
+                    if (entityCount < 0 || (uint64_t)entityCount * 61 > IOAddons::getRemainingLength(file)) {
+                        entityCount = 0;
+                        clearMapData();
+                        return 5; // Entity count doesn't match the file length; operation failed
+                    }
+
                     // Setting up arrays to store entity data
                     entityName = new std::string[entityCount];
                     entityTrigger = new std::string[entityCount];
@@ -133,8 +170,8 @@ int MapSystem::loadMap(std::string filePath) {
                     entityY = new int[entityCount];
 
                     // Setting up arrays to store setting inputs
-                    entitySettingInt = new int*[entityCount];
-                    entitySettingString = new std::string*[entityCount];
+                    entitySettingInt = new int*[entityCount]();
+                    entitySettingString = new std::string*[entityCount]();
                     for (int i = 0; i < entityCount; i ++) {
                         entityName[i] = IOAddons::readString(file); // Gets name input of the entity
                         entityType[i] = IOAddons::readByte(file); // Gets entity type
@@ -150,18 +187,24 @@ int MapSystem::loadMap(std::string filePath) {
                             entitySettingString[i][j] = IOAddons::readString(file); // Gets string setting input
                         }
                     }
+                } catch (std::bad_alloc&) {
+                    clearMapData(); // Removes everything that was allocated before running out of memory
+                    return 6; // Not enough memory to load the map; operation failed
+                }
 
-                    mapLoaded = true; // Map is loaded
-
-                    return 0; // Map loaded; operation was successful
-                } else {
-                    return 4; // Second header check failed; operation failed
+                if (file.fail()) { // Checks if everything was actually read
+                    clearMapData();
+                    return 5; // Map file ended early; operation failed
                 }
+
+                mapLoaded = true; // Map is loaded
+
+                return 0; // Map loaded; operation was successful
             } else {
-                return 3; // First header check failed; operation failed
+                return 4; // Second header check failed; operation failed
             }
         } else {
-            return 2; // Map file wasn't found; operation failed
+            return 3; // First header check failed; operation failed
         }
     } else {
         return 1; // Map is already loaded; operation failed
@@ -174,50 +217,72 @@ int MapSystem::loadMap(std::string filePath) {
 int MapSystem::unloadMap() {
     // If we have memory allocated in heap, remove it to prevent memory leaks
     if (mapLoaded) { // Checks if map is loaded
-        delete[] tileType; // Removing tile types array
+        clearMapData(); // Removing all the heap allocated arrays
+
+        mapLoaded = false;
+
+        return 0; // Heap allocated memory got removed, operation successful
+    } else {
+        return 1; // Map wasn't even loaded, nothing to remove (failure)
+    }
+}
 
-        // Removing tile frames array
+// Following function will remove all the map data allocated on heap, including partially loaded map data
+// Every pointer is reset to nullptr, so it is safe to call it more than once
+void MapSystem::clearMapData() {
+    delete[] tileType; // Removing tile types array
+    tileType = nullptr;
+
+    // Removing tile frames array
+    if (tileFrame != nullptr) {
         for (int x = 0; x <= mapWidth; x++) {
             delete[] tileFrame[x];
         }
         delete[] tileFrame;
+        tileFrame = nullptr;
+    }
 
-        // Removing modifier related arrays
-        if (useModifiers) { // Checks if map is using modifiers
+    // Removing modifier related arrays
+    int** modifierArrays[] = {tileModifier, tileModificationFrame, tileColorRed, tileColorGreen, tileColorBlue, tileOverlayFrame};
+    for (int i = 0; i < 6; i++) {
+        if (modifierArrays[i] != nullptr) {
             for (int x = 0; x <= mapWidth; x++) {
-                delete[] tileModifier[x];
-                delete[] tileModificationFrame[x];
-                delete[] tileColorRed[x];
-                delete[] tileColorGreen[x];
-                delete[] tileColorBlue[x];
-                delete[] tileOverlayFrame[x];
+                delete[] modifierArrays[i][x];
             }
-            delete[] tileModifier;
-            delete[] tileModificationFrame;
-            delete[] tileColorRed;
-            delete[] tileColorGreen;
-            delete[] tileColorBlue;
-            delete[] tileOverlayFrame;
+            delete[] modifierArrays[i];
         }
-
-        // Removing entity related arrays
-        delete[] entityName;
-        delete[] entityTrigger;
-        delete[] entityType;
-        delete[] entityX;
-        delete[] entityY;
+    }
+    tileModifier = nullptr;
+    tileModificationFrame = nullptr;
+    tileColorRed = nullptr;
+    tileColorGreen = nullptr;
+    tileColorBlue = nullptr;
+    tileOverlayFrame = nullptr;
+
+    // Removing entity related arrays
+    delete[] entityName;
+    delete[] entityTrigger;
+    delete[] entityType;
+    delete[] entityX;
+    delete[] entityY;
+    entityName = nullptr;
+    entityTrigger = nullptr;
+    entityType = nullptr;
+    entityX = nullptr;
+    entityY = nullptr;
+    if (entitySettingInt != nullptr) {
         for (int i = 0; i < entityCount; i++) {
             delete[] entitySettingInt[i];
-            delete[] entitySettingString[i];
         }
         delete[] entitySettingInt;
+        entitySettingInt = nullptr;
+    }
+    if (entitySettingString != nullptr) {
+        for (int i = 0; i < entityCount; i++) {
+            delete[] entitySettingString[i];
+        }
         delete[] entitySettingString;
-
-        mapLoaded = false;
-
-        return 0; // Heap allocated memory got removed, operation successful
-    } else {
-        return 1; // Map wasn't even loaded, nothing to remove (failure)
+        entitySettingString = nullptr;
     }
 }
 
@@ -227,99 +292,122 @@ int MapSystem::unloadMap() {
 int MapSystem::saveMap(std::string filePath) {
     std::ofstream file(filePath, std::ios::binary); // Opening output stream
     if (!file.fail()) {
-        IOAddons::writeString(file, "Unreal Software's Counter-Strike 2D Map File (max)"); // Writes first header
+        return saveMap(file);
+    } else {
+        return 1; // File wasn't found; operation failed
+    }
+}
 
-        // Byte settings
-        IOAddons::writeByte(file, scrollMapLikeTiles); // Will map scroll like tiles?
-        IOAddons::writeByte(file, useModifiers); // Will map use modifiers?
-        for (int i = 0; i < 8; i++) { // Fills in unused settings bytes
-            IOAddons::writeByte(file, 0);
-        }
+// Following function will write map data into a stream
+// Stream has to be opened in binary mode
+// Returns 0 if operation succeeded
+int MapSystem::saveMap(std::ostream& file) {
+    IOAddons::writeString(file, "Unreal Software's Counter-Strike 2D Map File (max)"); // Writes first header
+
+    // Byte settings
+    IOAddons::writeByte(file, scrollMapLikeTiles); // Will map scroll like tiles?
+    IOAddons::writeByte(file, useModifiers); // Will map use modifiers?
+    for (int i = 0; i < 8; i++) { // Fills in unused settings bytes
+        IOAddons::writeByte(file, 0);
+    }
 
-        // Int settings
-        IOAddons::writeInt(file, upTime); // Stores uptime
-        IOAddons::writeInt(file, USGNID); // Stores USGN ID of the map author
-        for (int i = 0; i < 8; i++) { // Fills in unused settings ints
-            IOAddons::writeInt(file, 0);
-        }
+    // Int settings
+    IOAddons::writeInt(file, upTime); // Stores uptime
+    IOAddons::writeInt(file, USGNID); // Stores USGN ID of the map author
+    for (int i = 0; i < 8; i++) { // Fills in unused settings ints
+        IOAddons::writeInt(file, 0);
+    }
 
-        // String settings
-        IOAddons::writeString(file, authorName); // Stores author's name
-        for (int i = 0; i < 9; i++) { // Fills in unused settings strings
-            IOAddons::writeString(file, "");
-        }
+    // String settings
+    IOAddons::writeString(file, authorName); // Stores author's name
+    for (int i = 0; i < 9; i++) { // Fills in unused settings strings
+        IOAddons::writeString(file, "");
+    }
+
+    // More map settings
+    IOAddons::writeString(file, generateSpecialString()); // Stores specially generated string
+    IOAddons::writeString(file, tilesetFileName); // Stores tileset filename
+    IOAddons::writeByte(file, requiredTilesCount); // Stores number of required tiles
+    IOAddons::writeInt(file, mapWidth); // Stores map width
+    IOAddons::writeInt(file, mapHeight); // Stores map height
+    IOAddons::writeString(file, backgroundFileName); // Stores background filename
+    IOAddons::writeInt(file, mapScrollXSpeed); // Stores map scroll x speed
+    IOAddons::writeInt(file, mapScrollYSpeed); // Stores map scroll y speed
+    IOAddons::writeByte(file, backgroundColorRed); // Stores background red value
+    IOAddons::writeByte(file, backgroundColorGreen); // Stores background green value
+    IOAddons::writeByte(file, backgroundColorBlue); // Stores background blue value
+
+    // Second header
+    IOAddons::writeString(file, "ed.erawtfoslaernu"); // Writes second header
+
+    // Tile types
+    for (int i = 0; i <= requiredTilesCount; i++) {
+        IOAddons::writeByte(file, tileType[i]); // Stores tile types
+    }
 
-        // More map settings
-        IOAddons::writeString(file, generateSpecialString()); // Stores specially generated string
-        IOAddons::writeString(file, tilesetFileName); // Stores tileset filename
-        IOAddons::writeByte(file, requiredTilesCount); // Stores number of required tiles
-        IOAddons::writeInt(file, mapWidth); // Stores map width
-        IOAddons::writeInt(file, mapHeight); // Stores map height
-        IOAddons::writeString(file, backgroundFileName); // Stores background filename
-        IOAddons::writeInt(file, mapScrollXSpeed); // Stores map scroll x speed
-        IOAddons::writeInt(file, mapScrollYSpeed); // Stores map scroll y speed
-        IOAddons::writeByte(file, backgroundColorRed); // Stores background red value
-        IOAddons::writeByte(file, backgroundColorGreen); // Stores background green value
-        IOAddons::writeByte(file, backgroundColorBlue); // Stores background blue value
-
-        // Second header
-        IOAddons::writeString(file, "ed.erawtfoslaernu"); // Writes second header
-
-        // Tile types
-        for (int i = 0; i <= requiredTilesCount; i++) {
-            IOAddons::writeByte(file, tileType[i]); // Stores tile types
+    // Tile frames
+    for (int x = 0; x <= mapWidth; x++) {
+        for (int y = 0; y <= mapHeight; y++) {
+            IOAddons::writeByte(file, tileFrame[x][y]); // Stores tile frames
         }
+    }
 
-        // Tile frames
+    // Tile modifiers
+    if (useModifiers == 1) {
         for (int x = 0; x <= mapWidth; x++) {
             for (int y = 0; y <= mapHeight; y++) {
-                IOAddons::writeByte(file, tileFrame[x][y]); // Stores tile frames
-            }
-        }
-
-        // Tile modifiers
-        if (useModifiers == 1) {
-            for (int x = 0; x <= mapWidth; x++) {
-                for (int y = 0; y <= mapHeight; y++) {
-                    IOAddons::writeByte(file, tileModifier[x][y]); // Stores tile modifier
-                    int modifier = tileModifier[x][y]; // Variable for shorter usage
-
-                    if ((modifier & 128) || (modifier & 64)) {
-                        if ((modifier & 64) && (modifier & 128)) {
-                            IOAddons::writeString(file, ""); // Writes empty string
-                        } else if ((modifier & 64) || !(modifier & 128)) {
-                            IOAddons::writeByte(file, tileModificationFrame[x][y]); // Stores modification frame
-                        } else {
-                            IOAddons::writeByte(file, tileColorRed[x][y]); // Stores red color value of that tile
-                            IOAddons::writeByte(file, tileColorGreen[x][y]); // Stores green color value of that tile
-                            IOAddons::writeByte(file, tileColorBlue[x][y]); // Stores blue color value of that tile
-                            IOAddons::writeByte(file, tileOverlayFrame[x][y]); // Stores tile overlay frame
-                        }
+                IOAddons::writeByte(file, tileModifier[x][y]); // Stores tile modifier
+                int modifier = tileModifier[x][y]; // Variable for shorter usage
+
+                if ((modifier & 128) || (modifier & 64)) {
+                    if ((modifier & 64) && (modifier & 128)) {
+                        IOAddons::writeString(file, ""); // Writes empty string
+                    } else if ((modifier & 64) || !(modifier & 128)) {
+                        IOAddons::writeByte(file, tileModificationFrame[x][y]); // Stores modification frame
+                    } else {
+                        IOAddons::writeByte(file, tileColorRed[x][y]); // Stores red color value of that tile
+                        IOAddons::writeByte(file, tileColorGreen[x][y]); // Stores green color value of that tile
+                        IOAddons::writeByte(file, tileColorBlue[x][y]); // Stores blue color value of that tile
+                        IOAddons::writeByte(file, tileOverlayFrame[x][y]); // Stores tile overlay frame
                     }
                 }
             }
-            // Removing modifier related arrays from heap memory
         }
+        // Removing modifier related arrays from heap memory
+    }
 
-        // Entities
-        IOAddons::writeInt(file, entityCount); // Stores number of entities used in this map
+    // Entities
+    IOAddons::writeInt(file, entityCount); // Stores number of entities used in this map
 
-        for (int i = 0; i < entityCount; i++) {
-            IOAddons::writeString(file, entityName[i]); // Stores entity name input
-            IOAddons::writeByte(file, entityType[i]); // Stores entity type
-            IOAddons::writeInt(file, entityX[i]); // Stores entity x position
-            IOAddons::writeInt(file, entityY[i]); // Stores entity y position
-            IOAddons::writeString(file, entityTrigger[i]); // Stores entity trigger input
-
-            for (int j = 0; j < 10; j++) {
-                IOAddons::writeInt(file, entitySettingInt[i][j]); // Stores entity settings ints
-                IOAddons::writeString(file, entitySettingString[i][j]); // Stores entity settings strings
-            }
+    for (int i = 0; i < entityCount; i++) {
+        IOAddons::writeString(file, entityName[i]); // Stores entity name input
+        IOAddons::writeByte(file, entityType[i]); // Stores entity type
+        IOAddons::writeInt(file, entityX[i]); // Stores entity x position
+        IOAddons::writeInt(file, entityY[i]); // Stores entity y position
+        IOAddons::writeString(file, entityTrigger[i]); // Stores entity trigger input
+
+        for (int j = 0; j < 10; j++) {
+            IOAddons::writeInt(file, entitySettingInt[i][j]); // Stores entity settings ints
+            IOAddons::writeString(file, entitySettingString[i][j]); // Stores entity settings strings
         }
+    }
 
-        return 0; // Map saved; operation was successful
-    } else {
-        return 1; // File wasn't found; operation failed
+    return 0; // Map saved; operation was successful
+}
+
+// Following function will store map data into the in-memory buffer, replacing its contents
+// Returns 0 if operation succeeded
+// Returns 2 if there is not enough memory to store the map (failure)
+int MapSystem::saveMapToBuffer(std::string& buffer) {
+    try {
+        std::ostringstream stream(std::ios::binary);
+        int result = saveMap(stream);
+        buffer = stream.str();
+
+        return result;
+    } catch (std::bad_alloc&) {
+        buffer.clear();
+        return 2; // Not enough memory to store the map; operation failed
     }
 }
 
@@ -334,28 +422,7 @@ int MapSystem::generateLuaScript(std::string filePath) {
         file.open(filePath); // Opens output file stream
 
         if (!(file.fail())) { // Checks if loading file was successful
-            // Generates the Lua script
-            file << "mapProtection = {\n";
-            file << "    map = {\n";
-            for (int x = 0; x <= mapWidth; x++) {
-                file << "        [" << x << "] = {\n";
-                for (int y = 0; y <= mapHeight; y++) {
-                    file << "            [" << y << "] = " << tileFrame[x][y] << ";\n";
-                }
-                file << "        };\n";
-            }
-            file << "    };\n\n";
-            file << "    generateMap = function()\n";
-            file << "        for x = 0, map'xsize' do\n";
-            file << "            for y = 0, map'ysize' do\n";
-            file << "                parse('settile '.. x ..' '.. y ..' '.. mapProtection.map[x][y])\n";
-            file << "            end\n";
-            file << "        end\n";
-            file << "    end;\n";
-            file << "}\n\n";
-            file << "mapProtection.generateMap()";
-
-            return 0; // Script was generated, operation was successful
+            return generateLuaScript(file);
         } else {
             return 2; // File wasn't found, operation failed
         }
@@ -364,37 +431,114 @@ int MapSystem::generateLuaScript(std::string filePath) {
     }
 }
 
+// Following function will write the tile generation script in Lua into a stream
+// Should be called BEFORE the removeTiles() function!!!
+// Returns 0 if operation was successful
+// Returns 1 if map is not loaded (failure)
+int MapSystem::generateLuaScript(std::ostream& file) {
+    if (mapLoaded) { // Checks if map is loaded
+        // Generates the Lua script
+        file << "mapProtection = {\n";
+        file << "    map = {\n";
+        for (int x = 0; x <= mapWidth; x++) {
+            file << "        [" << x << "] = {\n";
+            for (int y = 0; y <= mapHeight; y++) {
+                file << "            [" << y << "] = " << tileFrame[x][y] << ";\n";
+            }
+            file << "        };\n";
+        }
+        file << "    };\n\n";
+        file << "    generateMap = function()\n";
+        file << "        for x = 0, map'xsize' do\n";
+        file << "            for y = 0, map'ysize' do\n";
+        file << "                parse('settile '.. x ..' '.. y ..' '.. mapProtection.map[x][y])\n";
+        file << "            end\n";
+        file << "        end\n";
+        file << "    end;\n";
+        file << "}\n\n";
+        file << "mapProtection.generateMap()";
+
+        return 0; // Script was generated, operation was successful
+    } else {
+        return 1; // Map isn't loaded, operation failed
+    }
+}
+
+// Following function will store the tile generation script in Lua into the in-memory buffer, replacing its contents
+// Line breaks are not converted, write the buffer in text mode to get the same file as generateLuaScript() does
+// Should be called BEFORE the removeTiles() function!!!
+// Returns 0 if operation was successful
+// Returns 1 if map is not loaded (failure)
+// Returns 2 if there is not enough memory to store the script (failure)
+int MapSystem::generateLuaScriptToBuffer(std::string& buffer) {
+    try {
+        std::ostringstream stream;
+        int result = generateLuaScript(stream);
+        buffer = stream.str();
+
+        return result;
+    } catch (std::bad_alloc&) {
+        buffer.clear();
+        return 2; // Not enough memory to store the script; operation failed
+    }
+}
+
 // Following function will remove all the tiles from loaded map with the exception of tiles which have modifiers in it
 // Returns 0 if operation was successful
 // Returns 1 if map is not loaded (failure)
+// Returns 2 if there is not enough memory, tiles are left untouched (failure)
 int MapSystem::removeTiles() {
     if (mapLoaded) { // If map is loaded
-        int mapException[mapWidth + 1][mapHeight + 1]; // Declares a 2D array which will decide which tile WON'T get removed
-        memset(mapException, 0, sizeof(mapException[0][0]) * (mapWidth+1) * (mapHeight+1)); // Defaulting everything in the array to 0
+        // Declares an array which will decide which tile WON'T get removed, everything defaults to 0
+        // It is stored on heap and indexed as x * (mapHeight+1) + y, so that huge maps don't overflow the stack
+        size_t rowSize = (size_t)mapHeight + 1;
+        std::vector<char> mapException;
+        try {
+            mapException.assign(((size_t)mapWidth + 1) * rowSize, 0);
+        } catch (std::bad_alloc&) {
+            return 2; // Not enough memory to remove the tiles; operation failed
+        }
+
         // Checking tiles for modifiers, if they do have modifiers, add them to the exception array
-        if (useModifiers) { // Does map have modifiers enabled?
+        if (useModifiers == 1) { // Does map have modifiers enabled?
             for (int x = 0; x <= mapWidth; x++) {
                 for (int y = 0; y <= mapHeight; y++) {
                     if (tileModifier[x][y] != 0) { // Checks if the modifier in this tile is not equals to zero
                         int m = tileModificationFrame[x][y]; // Shortcut for faster usage
+                        int offsetX = 0; // Offset of the neighbouring tile which also won't get removed
+                        int offsetY = 0;
                         if (m == 7 || m == 15 || m == 23 || m == 31 || m == 39) {
-                            mapException[x-1][y-1] = 1;
+                            offsetX = -1;
+                            offsetY = -1;
                         } else if (m == 1 || m == 9 || m == 17 || m == 25 || m == 33) {
-                            mapException[x+1][y-1] = 1;
+                            offsetX = 1;
+                            offsetY = -1;
                         } else if (m == 3 || m == 11 || m == 19 || m == 27 || m == 35) {
-                            mapException[x+1][y+1] = 1;
+                            offsetX = 1;
+                            offsetY = 1;
                         } else if (m == 5 || m == 13 || m == 21 || m == 29 || m == 37) {
-                            mapException[x-1][y+1] = 1;
+                            offsetX = -1;
+                            offsetY = 1;
                         } else if (m == 6 || m == 14 || m == 22 || m == 30 || m == 38) {
-                            mapException[x-1][y] = 1;
+                            offsetX = -1;
+                            offsetY = 0;
                         } else if (m == 0 || m == 8 || m == 16 || m == 24 || m == 32) {
-                            mapException[x][y-1] = 1;
+                            offsetX = 0;
+                            offsetY = -1;
                         } else if (m == 4 || m == 12 || m == 20 || m == 28 || m == 36) {
-                            mapException[x][y+1] = 1;
+                            offsetX = 0;
+                            offsetY = 1;
                         } else if (m == 2 || m == 10 || m == 18 || m == 26 || m == 34) {
-                            mapException[x+1][y] = 1;
+                            offsetX = 1;
+                            offsetY = 0;
                         }
-                        mapException[x][y] = 1;
+
+                        int exceptionX = x + offsetX;
+                        int exceptionY = y + offsetY;
+                        if (exceptionX >= 0 && exceptionX <= mapWidth && exceptionY >= 0 && exceptionY <= mapHeight) { // Neighbouring tile has to be inside of the map
+                            mapException[exceptionX * rowSize + exceptionY] = 1;
+                        }
+                        mapException[x * rowSize + y] = 1;
                     }
                 }
             }
@@ -403,7 +547,7 @@ int MapSystem::removeTiles() {
         // Removing tiles from map
         for (int x = 0; x <= mapWidth; x++) {
             for (int y = 0; y <= mapHeight; y++) {
-                if (mapException[x][y] == 0) { // Checks if this tile is not in the exceptions array
+                if (mapException[x * rowSize + y] == 0) { // Checks if this tile is not in the exceptions array
                     tileFrame[x][y] = 0; // Removes tile
                 }
             }
@@ -424,11 +568,35 @@ std::string MapSystem::generateSpecialString() {
     char resultString[256];
     unsigned int upTime = GetTickCount();
 
+    // localtime() uses a shared buffer, so it has to be guarded when maps are saved on multiple threads
+    static std::mutex timeMutex;
+    std::unique_lock<std::mutex> lock(timeMutex);
     std::time(&rawtime);
     timeinfo = std::localtime(&rawtime);
 
     std::strftime(timeString, 80, "%H%M%S", timeinfo);
+    lock.unlock();
 
-    sprintf(resultString, "%dx%d$%s%%%d", mapWidth*mapHeight, requiredTilesCount, timeString, upTime);
+    sprintf(resultString, "%lldx%d$%s%%%d", (long long)mapWidth * mapHeight, requiredTilesCount, timeString, upTime);
     return resultString;
 }
+
+// Returns width of the currently loaded map
+int MapSystem::getMapWidth() {
+    return mapWidth;
+}
+
+// Returns height of the currently loaded map
+int MapSystem::getMapHeight() {
+    return mapHeight;
+}
+
+// Returns tile frame on specified position of the currently loaded map
+// Returns 0 if map is not loaded or position is outside of the map
+int MapSystem::getTileFrame(int x, int y) {
+    if (mapLoaded && x >= 0 && x <= mapWidth && y >= 0 && y <= mapHeight) {
+        return tileFrame[x][y];
+    } else {
+        return 0;
+    }
+}
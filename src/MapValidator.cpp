@@ -0,0 +1,301 @@
+#include "MapValidator.h"
+#include "IOAddons.h"
+
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <thread>
+
+// Following function will check structure of the whole map data, the same way loadMap() reads it
+// Nothing is allocated per tile or per entity, so even huge maps are checked quickly
+// Result code is stored in the returned structure:
+// 0 if map is valid
+// 1 if map file was not read (set by validateMaps())
+// 2 if map has failed first header check
+// 3 if map has failed second header check
+// 4 if declared map sizes are invalid
+// 5 if map file ends early in the header
+// 6 if map file ends early in the tiles section
+// 7 if map file ends early in the modifiers section
+// 8 if declared entity count doesn't fit in the file
+// 9 if map file ends early in the entities section
+// 10 if there is not enough memory to read the map file (set by validateMaps())
+MapValidation MapValidator::validateMap(const std::string& data) {
+    MapValidation validation;
+    validation.fileLength = data.length();
+    uint64_t& position = validation.offset; // Offset is moved together with the position
+    std::string value;
+    int useModifiers = 0;
+    int requiredTilesCount = 0;
+
+    // Header
+    if (!readString(data, position, value)) {
+        validation.result = 5;
+        return validation;
+    }
+    if (value != "Unreal Software's Counter-Strike 2D Map File (max)") { // First header check
+        validation.result = 2;
+        return validation;
+    }
+
+    bool headerRead = skipBytes(data, position, 1) // Scroll map like tiles
+            && readByte(data, position, useModifiers) // Use modifiers
+            && skipBytes(data, position, 8) // Unused settings bytes
+            && skipBytes(data, position, 10 * 4); // Uptime, USGN ID and unused settings ints
+    for (int i = 0; i < 12 && headerRead; i++) { // Author name, unused settings strings, special string and tileset filename
+        headerRead = skipString(data, position);
+    }
+    headerRead = headerRead
+            && readByte(data, position, requiredTilesCount)
+            && readInt(data, position, validation.mapWidth)
+            && readInt(data, position, validation.mapHeight)
+            && skipString(data, position) // Background filename
+            && skipBytes(data, position, 2 * 4 + 3) // Scroll speeds and background color
+            && readString(data, position, value);
+    if (!headerRead) {
+        validation.result = 5;
+        return validation;
+    }
+    if (value != "ed.erawtfoslaernu") { // Second header check
+        validation.result = 3;
+        return validation;
+    }
+
+    // Map sizes
+    if (validation.mapWidth < 0 || validation.mapHeight < 0 || validation.mapWidth == INT32_MAX || validation.mapHeight == INT32_MAX) {
+        validation.result = 4;
+        return validation;
+    }
+    uint64_t tileCount = (uint64_t)(validation.mapWidth + 1) * (uint64_t)(validation.mapHeight + 1);
+
+    // Tile types and tile frames
+    if (!skipBytes(data, position, requiredTilesCount + 1) || !skipBytes(data, position, tileCount)) {
+        validation.result = 6;
+        return validation;
+    }
+
+    // Tile modifiers
+    if (useModifiers == 1) {
+        if (tileCount > data.length() - position) { // Every tile has at least one modifier byte
+            validation.result = 7;
+            return validation;
+        }
+        for (uint64_t i = 0; i < tileCount; i++) {
+            int modifier;
+            bool modifierRead = readByte(data, position, modifier);
+            if (modifierRead && ((modifier & 128) || (modifier & 64))) {
+                if ((modifier & 64) && (modifier & 128)) {
+                    modifierRead = skipString(data, position); // Unused string
+                } else if ((modifier & 64) || !(modifier & 128)) {
+                    modifierRead = skipBytes(data, position, 1); // Modification frame
+                } else {
+                    modifierRead = skipBytes(data, position, 4); // Color and overlay frame
+                }
+            }
+            if (!modifierRead) {
+                validation.result = 7;
+                return validation;
+            }
+        }
+    }
+
+    // Entities
+    if (!readInt(data, position, validation.entityCount)) {
+        validation.result = 9;
+        return validation;
+    }
+    if (validation.entityCount < 0 || (uint64_t)validation.entityCount * 61 > data.length() - position) { // Every entity takes at least 61 bytes
+        validation.result = 8;
+        return validation;
+    }
+    for (int i = 0; i < validation.entityCount; i++) {
+        bool entityRead = skipString(data, position) // Name
+                && skipBytes(data, position, 1 + 2 * 4) // Type and position
+                && skipString(data, position); // Trigger
+        for (int j = 0; j < 10 && entityRead; j++) { // Settings
+            entityRead = skipBytes(data, position, 4) && skipString(data, position);
+        }
+        if (!entityRead) {
+            validation.result = 9;
+            return validation;
+        }
+    }
+
+    return validation; // Map is valid
+}
+
+// Returns name of the result code, used in the report
+std::string MapValidator::getResultName(int result) {
+    switch (result) {
+        case 0: return "ok";
+        case 1: return "unreadable";
+        case 2: return "bad_header";
+        case 3: return "bad_second_header";
+        case 4: return "bad_map_size";
+        case 5: return "truncated_header";
+        case 6: return "truncated_tiles";
+        case 7: return "truncated_modifiers";
+        case 8: return "bad_entity_count";
+        case 9: return "truncated_entities";
+        case 10: return "out_of_memory";
+        default: return "unknown";
+    }
+}
+
+// Following function will check all specified maps in parallel
+// Returns number of invalid maps
+int MapValidator::validateMaps(std::vector<std::string> mapPaths, int workerCount) {
+    if (workerCount < 1) {
+        workerCount = 1;
+    }
+
+    this->mapPaths = mapPaths;
+    mapResults.assign(mapPaths.size(), MapValidation());
+    nextMap = 0;
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < workerCount; i++) {
+        workers.push_back(std::thread(&MapValidator::validateFiles, this));
+    }
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+
+    int invalidCount = 0;
+    for (size_t i = 0; i < mapResults.size(); i++) {
+        if (mapResults[i].result != 0) {
+            invalidCount++;
+        }
+    }
+    return invalidCount;
+}
+
+// Returns result of the map with specified index
+MapValidation MapValidator::getResult(int index) {
+    return mapResults[index];
+}
+
+// Writes report of the last validation, one JSON object per map
+void MapValidator::writeReport(std::ostream& stream) {
+    for (size_t i = 0; i < mapResults.size(); i++) {
+        // Escaping the path, since Windows paths contain backslashes and file names may contain control characters
+        // Bytes above 0x7F are escaped as well, paths come in the local code page and would not be valid UTF-8
+        std::string path;
+        for (size_t j = 0; j < mapPaths[i].length(); j++) {
+            unsigned char c = mapPaths[i][j];
+            if (c == '\\' || c == '"') {
+                path += '\\';
+                path += c;
+            } else if (c == '\n') {
+                path += "\\n";
+            } else if (c == '\r') {
+                path += "\\r";
+            } else if (c == '\t') {
+                path += "\\t";
+            } else if (c < 0x20 || c > 0x7F) {
+                char escaped[7];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                path += escaped;
+            } else {
+                path += c;
+            }
+        }
+
+        const MapValidation& validation = mapResults[i];
+        stream << "{\"path\":\"" << path << "\""
+               << ",\"valid\":" << (validation.result == 0 ? "true" : "false")
+               << ",\"result\":\"" << getResultName(validation.result) << "\""
+               << ",\"offset\":" << validation.offset
+               << ",\"length\":" << validation.fileLength
+               << ",\"width\":" << validation.mapWidth
+               << ",\"height\":" << validation.mapHeight
+               << ",\"entities\":" << validation.entityCount << "}\n";
+    }
+}
+
+// Moves position by specified number of bytes
+// Returns false if there are not enough bytes left
+bool MapValidator::skipBytes(const std::string& data, uint64_t& position, uint64_t count) {
+    if (count > data.length() - position) {
+        return false;
+    }
+    position += count;
+    return true;
+}
+
+// Moves position past the next line break
+// Follows the same rule as std::getline() in IOAddons::readString(): string which ends at the end of the file
+// without a line break is accepted, as long as it isn't empty
+// Returns false if there is nothing left to read
+bool MapValidator::skipString(const std::string& data, uint64_t& position) {
+    if (position >= data.length()) {
+        return false;
+    }
+
+    const char* lineBreak = (const char*)std::memchr(data.data() + position, '\n', data.length() - position);
+    if (lineBreak == nullptr) {
+        position = data.length(); // Last string of the file
+    } else {
+        position = lineBreak - data.data() + 1;
+    }
+    return true;
+}
+
+// Reads a string up to line break, carriage returns are removed the same way IOAddons::readString() does
+// Returns false if there is nothing left to read
+bool MapValidator::readString(const std::string& data, uint64_t& position, std::string& value) {
+    uint64_t start = position;
+    if (!skipString(data, position)) {
+        return false;
+    }
+    value.clear();
+    for (uint64_t i = start; i < position; i++) {
+        if (data[i] != '\r' && data[i] != '\n') {
+            value += data[i];
+        }
+    }
+    return true;
+}
+
+// Reads unsigned 8-bit byte
+// Returns false if there are not enough bytes left
+bool MapValidator::readByte(const std::string& data, uint64_t& position, int& value) {
+    if (position >= data.length()) {
+        return false;
+    }
+    value = (uint8_t)data[position];
+    position++;
+    return true;
+}
+
+// Reads signed 32-bit integer
+// Returns false if there are not enough bytes left
+bool MapValidator::readInt(const std::string& data, uint64_t& position, int& value) {
+    if (data.length() - position < 4) {
+        return false;
+    }
+    int32_t readValue;
+    std::memcpy(&readValue, data.data() + position, sizeof(readValue));
+    value = readValue;
+    position += 4;
+    return true;
+}
+
+// Takes maps one by one and validates them, file buffer is reused between the maps
+void MapValidator::validateFiles() {
+    std::string data;
+    size_t index;
+    while ((index = nextMap++) < mapPaths.size()) {
+        int result;
+        try {
+            result = IOAddons::readFile(mapPaths[index], data);
+        } catch (std::exception&) {
+            result = 1; // Exception must not leave the worker thread
+        }
+        if (result != 0) {
+            mapResults[index].result = result == 3 ? 10 : 1; // Map file wasn't read or there is not enough memory
+            continue;
+        }
+        mapResults[index] = validateMap(data);
+    }
+}